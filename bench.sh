@@ -0,0 +1,17 @@
+#!/bin/sh
+set -e
+
+TARGET=../src/bench.c
+BINARY=bench
+LARGE_BINARY=bench_64x64
+
+COMPILER_FLAGS="-std=c99 -O2 -g -Wall"
+LARGE_MAP_FLAGS="-DMAP_WIDTH=64 -DMAP_HEIGHT=64"
+
+mkdir -p build
+cd build
+
+${CC:-cc} $TARGET $COMPILER_FLAGS -o $BINARY
+${CC:-cc} $TARGET $COMPILER_FLAGS $LARGE_MAP_FLAGS -o $LARGE_BINARY
+
+./$BINARY "$@"
@@ -3,11 +3,19 @@
 set TARGET=../src/main.c
 set BINARY=snake.exe
 
+set BENCH_TARGET=../src/bench.c
+set BENCH_BINARY=bench.exe
+set BENCH_LARGE_BINARY=bench_64x64.exe
+
 set COMPILER_FLAGS=-nologo -FC -Od -Oi -Z7 -Gw -GS- -Gs9999999
+set BENCH_COMPILER_FLAGS=-nologo -FC -O2 -Z7
+set BENCH_LARGE_MAP_FLAGS=-DMAP_WIDTH=64 -DMAP_HEIGHT=64
 set LINKER_FLAGS=-driver -align:16 -stack:0x100000,0x100000 -incremental:no -opt:ref -emitpogophaseinfo -subsystem:windows
 
 pushd build
 
 cl %TARGET% %COMPILER_FLAGS% -link %LINKER_FLAGS% -out:%BINARY%
+cl %BENCH_TARGET% %BENCH_COMPILER_FLAGS% -Fe:%BENCH_BINARY%
+cl %BENCH_TARGET% %BENCH_COMPILER_FLAGS% %BENCH_LARGE_MAP_FLAGS% -Fe:%BENCH_LARGE_BINARY%
 
 popd
\ No newline at end of file
@@ -0,0 +1,843 @@
+#if !defined(_WIN32) && !defined(__APPLE__)
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+// NOTE: By default the bench is built with the game's own map capacity so the
+// board scenarios time exactly the code the game runs. Building with a larger
+// -DMAP_WIDTH/-DMAP_HEIGHT runs only the board scenarios of that size.
+#if defined(MAP_WIDTH) || defined(MAP_HEIGHT)
+#define BENCH_CUSTOM_MAP 1
+#else
+#define BENCH_CUSTOM_MAP 0
+#endif
+
+#include "snake.c"
+
+//------------------------------------------------------------------------------
+// Timing
+//------------------------------------------------------------------------------
+static double
+GetSeconds(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER freq, counter;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+}
+
+//------------------------------------------------------------------------------
+// Deterministic Random
+//------------------------------------------------------------------------------
+static unsigned long long randomState;
+
+static void
+SeedRandom(unsigned long long seed)
+{
+    randomState = seed ? seed : 0x9E3779B97F4A7C15ull;
+}
+
+static unsigned int
+NextRandom(void)
+{
+    // xorshift64*
+    randomState ^= randomState >> 12;
+    randomState ^= randomState << 25;
+    randomState ^= randomState >> 27;
+    return (unsigned int)((randomState * 0x2545F4914F6CDD1Dull) >> 32);
+}
+
+static void
+BenchGenRandom(void *randomBuffer, unsigned int randomBufferLength)
+{
+    unsigned char *byte = (unsigned char *)randomBuffer;
+    
+    while(randomBufferLength)
+    {
+        unsigned int value = NextRandom();
+        unsigned int count = Min(randomBufferLength, (unsigned int)sizeof(value));
+        memcpy(byte, &value, count);
+        byte += count;
+        randomBufferLength -= count;
+    }
+}
+
+//------------------------------------------------------------------------------
+// Scenarios
+//------------------------------------------------------------------------------
+typedef enum
+{
+    BENCH_UPDATE_GAMEPLAY,
+    BENCH_PLACE_FRUIT,
+    BENCH_CLEAR_SCREEN_BUFFER,
+    BENCH_FILL_RECTANGLE,
+    BENCH_DRAW_SINGLE_NUMBER,
+    BENCH_RENDER_GAME,
+} bench_kind;
+
+typedef struct
+{
+    char *name;
+    bench_kind kind;
+    
+    int mapWidth, mapHeight;
+    int bufferWidth, bufferHeight;
+    
+    // Snake length in tiles (gameplay, rendering) or number of empty tiles
+    // left on the board (fruit placement). Unused by the other kinds.
+    int tiles;
+    
+    // Gameplay only: fruit laid out ahead of the snake so it grows while the
+    // ticks are timed, and whether the board wraps around its edges.
+    int fruit;
+    int screenWrap;
+    
+    unsigned long long seed;
+    int opsPerSample;
+
+} bench_scenario;
+
+static bench_scenario scenarios[] =
+{
+    // name, kind, map size, buffer size, tiles, fruit, screen wrap, seed, ops per sample
+    { "update_gameplay_15x15_len4",          BENCH_UPDATE_GAMEPLAY,     15, 15,    0,    0,    4,    0, 0,  1, 1 << 20 },
+    { "update_gameplay_15x15_len150",        BENCH_UPDATE_GAMEPLAY,     15, 15,    0,    0,  150,    0, 0,  2, 1 << 20 },
+    { "update_gameplay_15x15_grow",          BENCH_UPDATE_GAMEPLAY,     15, 15,    0,    0,    4,  150, 0,  3, 1 << 20 },
+    { "update_gameplay_wrap_15x15_len150",   BENCH_UPDATE_GAMEPLAY,     15, 15,    0,    0,  150,    0, 1,  4, 1 << 20 },
+    { "update_gameplay_wrap_15x15_grow",     BENCH_UPDATE_GAMEPLAY,     15, 15,    0,    0,  100,  100, 1,  5, 1 << 20 },
+    { "update_gameplay_64x64_len4",          BENCH_UPDATE_GAMEPLAY,     64, 64,    0,    0,    4,    0, 0,  6, 1 << 20 },
+    { "update_gameplay_64x64_grow",          BENCH_UPDATE_GAMEPLAY,     64, 64,    0,    0,    4, 3000, 0,  7, 1 << 20 },
+    { "update_gameplay_wrap_64x64_len2000",  BENCH_UPDATE_GAMEPLAY,     64, 64,    0,    0, 2000,    0, 1,  8, 1 << 20 },
+    
+    { "place_fruit_15x15_free1",             BENCH_PLACE_FRUIT,         15, 15,    0,    0,    1,    0, 0,  9, 1 << 12 },
+    { "place_fruit_15x15_free8",             BENCH_PLACE_FRUIT,         15, 15,    0,    0,    8,    0, 0, 10, 1 << 14 },
+    { "place_fruit_64x64_free1",             BENCH_PLACE_FRUIT,         64, 64,    0,    0,    1,    0, 0, 11, 1 << 8  },
+    { "place_fruit_64x64_free32",            BENCH_PLACE_FRUIT,         64, 64,    0,    0,   32,    0, 0, 12, 1 << 12 },
+    
+    { "clear_screen_buffer_640x480",         BENCH_CLEAR_SCREEN_BUFFER, 0,  0,  640,  480,    0,    0, 0, 13, 1 << 9 },
+    { "clear_screen_buffer_1920x1080",       BENCH_CLEAR_SCREEN_BUFFER, 0,  0, 1920, 1080,    0,    0, 0, 14, 1 << 5 },
+    { "clear_screen_buffer_3840x2160",       BENCH_CLEAR_SCREEN_BUFFER, 0,  0, 3840, 2160,    0,    0, 0, 15, 1 << 3 },
+    
+    { "fill_rectangle_640x480",              BENCH_FILL_RECTANGLE,      0,  0,  640,  480,    0,    0, 0, 16, 1 << 9 },
+    { "fill_rectangle_1920x1080",            BENCH_FILL_RECTANGLE,      0,  0, 1920, 1080,    0,    0, 0, 17, 1 << 5 },
+    { "fill_rectangle_3840x2160",            BENCH_FILL_RECTANGLE,      0,  0, 3840, 2160,    0,    0, 0, 18, 1 << 3 },
+    
+    { "draw_single_number_1920x1080",        BENCH_DRAW_SINGLE_NUMBER,  0,  0, 1920, 1080,    0,    0, 0, 19, 1 << 16 },
+    { "draw_single_number_3840x2160",        BENCH_DRAW_SINGLE_NUMBER,  0,  0, 3840, 2160,    0,    0, 0, 20, 1 << 14 },
+    
+    { "render_game_15x15_640x480",           BENCH_RENDER_GAME,         15, 15,  640,  480,   40,    0, 0, 21, 1 << 9 },
+    { "render_game_15x15_1920x1080",         BENCH_RENDER_GAME,         15, 15, 1920, 1080,   40,    0, 0, 22, 1 << 6 },
+    { "render_game_15x15_3840x2160",         BENCH_RENDER_GAME,         15, 15, 3840, 2160,   40,    0, 0, 23, 1 << 4 },
+    { "render_game_64x64_1920x1080",         BENCH_RENDER_GAME,         64, 64, 1920, 1080, 1024,    0, 0, 24, 1 << 6 },
+    { "render_game_64x64_3840x2160",         BENCH_RENDER_GAME,         64, 64, 3840, 2160, 1024,    0, 0, 25, 1 << 4 },
+};
+
+typedef struct
+{
+    double nsPerOp;
+    double mbPerSecond;
+    long long opsPerSample;
+    unsigned int checksum;
+
+} bench_result;
+
+static unsigned int *benchBuffer;
+static snake_state benchState;
+static snake_state benchStateTemplate;
+static unsigned int benchFruitChecksum;
+
+// NOTE: A closed path over the board the snake can follow forever without
+// running into a wall or itself, indexed in path order and by map index.
+static int benchCycle[MAP_WIDTH * MAP_HEIGHT];
+static int benchCycleLength;
+static int benchNextDirX[MAP_WIDTH * MAP_HEIGHT];
+static int benchNextDirY[MAP_WIDTH * MAP_HEIGHT];
+
+static int
+ScenarioFitsBuild(bench_scenario *scenario)
+{
+    int result = !BENCH_CUSTOM_MAP;
+    
+    if(scenario->mapWidth && scenario->mapHeight)
+    {
+        result = (scenario->mapWidth == MAP_WIDTH && scenario->mapHeight == MAP_HEIGHT);
+    }
+    
+    return result;
+}
+
+// NOTE: With screen wrap the path runs width-1 tiles right then one down,
+// which visits every tile of the torus once. Without it, the path snakes
+// through columns 1..width-1 row by row and returns up column 0. An odd last
+// row is left out so the path can close.
+static void
+BuildCycle(snake_map *map, int screenWrap)
+{
+    benchCycleLength = 0;
+    
+    if(screenWrap)
+    {
+        int x = 0;
+        int y = 0;
+        
+        for(int row = 0; row < map->height; row++)
+        {
+            for(int step = 0; step < map->width; step++)
+            {
+                benchCycle[benchCycleLength++] = MapIndex(map, x, y);
+                
+                if(step < map->width - 1)
+                {
+                    x = (x + 1) % map->width;
+                }
+            }
+            
+            y = (y + 1) % map->height;
+        }
+    }
+    else
+    {
+        int rows = map->height & ~1;
+        
+        for(int y = 0; y < rows; y++)
+        {
+            for(int step = 1; step < map->width; step++)
+            {
+                int x = (y & 1) ? map->width - step : step;
+                benchCycle[benchCycleLength++] = MapIndex(map, x, y);
+            }
+        }
+        
+        for(int y = rows - 1; y >= 0; y--)
+        {
+            benchCycle[benchCycleLength++] = MapIndex(map, 0, y);
+        }
+    }
+    
+    for(int index = 0;
+        index < benchCycleLength;
+        index++)
+    {
+        int from = benchCycle[index];
+        int to = benchCycle[(index + 1) % benchCycleLength];
+        
+        int dx = (to % map->width) - (from % map->width);
+        int dy = (to / map->width) - (from / map->width);
+        
+        benchNextDirX[from] = (dx > 1) ? -1 : (dx < -1) ? 1 : dx;
+        benchNextDirY[from] = (dy > 1) ? -1 : (dy < -1) ? 1 : dy;
+    }
+}
+
+// NOTE: Lays the snake out as a boustrophedon path from the top left corner so
+// every tile on it is a real segment the gameplay code could have produced.
+static void
+GrowSnake(snake_state *state, int length)
+{
+    memset(state->map.tiles, 0, sizeof(state->map.tiles));
+    
+    int tileCount = state->map.width * state->map.height;
+    length = Clamp(1, length, tileCount);
+    
+    for(int segment = 0;
+        segment < length;
+        segment++)
+    {
+        int y = segment / state->map.width;
+        int x = segment % state->map.width;
+        
+        if(y & 1)
+        {
+            x = state->map.width - 1 - x;
+        }
+        
+        state->snakeSegments[segment] = MapIndex(&state->map, x, y);
+        state->map.tiles[state->snakeSegments[segment]] = MAP_TILE_SNAKE;
+        
+        state->snakeX = x;
+        state->snakeY = y;
+    }
+    
+    state->snakeTailIndex = 0;
+    state->snakeHeadIndex = length - 1;
+}
+
+// NOTE: Puts the snake on the first tiles of the cycle and spreads the fruit
+// evenly over the tiles its head will reach during one growth run.
+static int
+LaySnakeOnCycle(snake_state *state, int length, int fruit)
+{
+    memset(state->map.tiles, 0, sizeof(state->map.tiles));
+    
+    length = Clamp(1, length, benchCycleLength - 1);
+    
+    int runLength = benchCycleLength - length;
+    fruit = Clamp(0, fruit, runLength - 1);
+    
+    for(int segment = 0;
+        segment < length;
+        segment++)
+    {
+        state->snakeSegments[segment] = benchCycle[segment];
+        state->map.tiles[benchCycle[segment]] = MAP_TILE_SNAKE;
+    }
+    
+    int head = benchCycle[length - 1];
+    
+    state->snakeTailIndex = 0;
+    state->snakeHeadIndex = length - 1;
+    state->snakeX = head % state->map.width;
+    state->snakeY = head / state->map.width;
+    state->snakeDirX = benchNextDirX[head];
+    state->snakeDirY = benchNextDirY[head];
+    
+    for(int fruitIndex = 0;
+        fruitIndex < fruit;
+        fruitIndex++)
+    {
+        int offset = fruitIndex * runLength / fruit;
+        state->map.tiles[benchCycle[length + offset]] = MAP_TILE_FRUIT;
+    }
+    
+    // Only growth runs have to restart from the template.
+    return fruit ? runLength : 0;
+}
+
+static int benchGrowthRunLength;
+
+static void
+SetupScenario(bench_scenario *scenario)
+{
+    SeedRandom(scenario->seed);
+    benchFruitChecksum = 2166136261u;
+    
+    switch(scenario->kind)
+    {
+        case BENCH_UPDATE_GAMEPLAY:
+        {
+            ResetGameState(&benchStateTemplate, scenario->mapWidth, scenario->mapHeight);
+            benchStateTemplate.screenWrap = scenario->screenWrap;
+            
+            BuildCycle(&benchStateTemplate.map, scenario->screenWrap);
+            benchGrowthRunLength = LaySnakeOnCycle(&benchStateTemplate, scenario->tiles, scenario->fruit);
+            
+            benchState = benchStateTemplate;
+        } break;
+        
+        case BENCH_PLACE_FRUIT:
+        {
+            ResetGameState(&benchStateTemplate, scenario->mapWidth, scenario->mapHeight);
+            
+            int tileCount = benchStateTemplate.map.width * benchStateTemplate.map.height;
+            GrowSnake(&benchStateTemplate, tileCount - Max(1, scenario->tiles));
+        } break;
+        
+        case BENCH_RENDER_GAME:
+        {
+            ResetGameState(&benchState, scenario->mapWidth, scenario->mapHeight);
+            GrowSnake(&benchState, scenario->tiles);
+            PlaceFruit(&benchState, BenchGenRandom);
+            benchState.score = 1234567890;
+        } break;
+        
+        default: break;
+    }
+    
+    if(scenario->bufferWidth && scenario->bufferHeight)
+    {
+        ClearScreenBuffer(benchBuffer, scenario->bufferWidth, scenario->bufferHeight, 0xFF111111);
+    }
+}
+
+// NOTE: Steers the snake along the precomputed cycle the way input would, so
+// every tick is a real move and the loop never hits game over. Growth runs
+// restore the board from the template between runs, outside the timed region.
+static double
+RunUpdateGameplay(bench_scenario *scenario)
+{
+    double elapsed = 0;
+    int remaining = scenario->opsPerSample;
+    
+    while(remaining)
+    {
+        int ticks = remaining;
+        
+        if(benchGrowthRunLength)
+        {
+            benchState = benchStateTemplate;
+            ticks = Min(ticks, benchGrowthRunLength);
+        }
+        
+        double begin = GetSeconds();
+        
+        for(int tick = 0;
+            tick < ticks;
+            tick++)
+        {
+            int head = benchState.snakeSegments[benchState.snakeHeadIndex];
+            int dirX = benchNextDirX[head];
+            int dirY = benchNextDirY[head];
+            
+            if(dirX != benchState.snakeDirX || dirY != benchState.snakeDirY)
+            {
+                benchState.snakeRequestedDirX = dirX;
+                benchState.snakeRequestedDirY = dirY;
+            }
+            
+            UpdateGameplay(&benchState);
+        }
+        
+        elapsed += GetSeconds() - begin;
+        remaining -= ticks;
+    }
+    
+    return elapsed;
+}
+
+static void
+RunPlaceFruit(bench_scenario *scenario)
+{
+    for(int op = 0;
+        op < scenario->opsPerSample;
+        op++)
+    {
+        benchStateTemplate.fruitPlaced = 0;
+        int fruitIndex = PlaceFruit(&benchStateTemplate, BenchGenRandom);
+        
+        benchStateTemplate.map.tiles[fruitIndex] = MAP_TILE_EMPTY;
+        benchFruitChecksum = (benchFruitChecksum ^ (unsigned int)fruitIndex) * 16777619u;
+    }
+}
+
+static double
+RunScenario(bench_scenario *scenario)
+{
+    int width = scenario->bufferWidth;
+    int height = scenario->bufferHeight;
+    
+    if(scenario->kind == BENCH_UPDATE_GAMEPLAY)
+    {
+        return RunUpdateGameplay(scenario);
+    }
+    
+    double begin = GetSeconds();
+    
+    switch(scenario->kind)
+    {
+        case BENCH_PLACE_FRUIT:
+        {
+            RunPlaceFruit(scenario);
+        } break;
+        
+        case BENCH_CLEAR_SCREEN_BUFFER:
+        {
+            for(int op = 0; op < scenario->opsPerSample; op++)
+            {
+                ClearScreenBuffer(benchBuffer, width, height, 0xFF000000 | op);
+            }
+        } break;
+        
+        case BENCH_FILL_RECTANGLE:
+        {
+            // Partially off-screen so the clipping path is part of the measurement.
+            for(int op = 0; op < scenario->opsPerSample; op++)
+            {
+                FillRectangle(benchBuffer, width, height, -8, -8, width + 16, height + 16, 0xFF000000 | op);
+            }
+        } break;
+        
+        case BENCH_DRAW_SINGLE_NUMBER:
+        {
+            int digitWidth = (width / 400) * DIGIT_PIXELS_X;
+            int digitHeight = (width / 400) * DIGIT_PIXELS_Y;
+            
+            for(int op = 0; op < scenario->opsPerSample; op++)
+            {
+                DrawSingleNumber(benchBuffer, width, height, op % 10, width / 2, height / 2, digitWidth, digitHeight, 0xFFDDDDDD);
+            }
+        } break;
+        
+        case BENCH_RENDER_GAME:
+        {
+            for(int op = 0; op < scenario->opsPerSample; op++)
+            {
+                RenderGame(&benchState, benchBuffer, width, height, BenchGenRandom);
+            }
+        } break;
+        
+        default: break;
+    }
+    
+    return GetSeconds() - begin;
+}
+
+static unsigned int
+ComputeChecksum(bench_scenario *scenario)
+{
+    unsigned int checksum = 2166136261u;
+    
+    if(scenario->bufferWidth && scenario->bufferHeight)
+    {
+        unsigned int *pixel = benchBuffer;
+        unsigned int *end = pixel + scenario->bufferWidth * scenario->bufferHeight;
+        
+        while(pixel != end)
+        {
+            checksum = (checksum ^ *pixel++) * 16777619u;
+        }
+    }
+    else
+    {
+        snake_state *state = (scenario->kind == BENCH_PLACE_FRUIT) ? &benchStateTemplate : &benchState;
+        
+        checksum = (checksum ^ state->score) * 16777619u;
+        checksum = (checksum ^ (unsigned int)state->snakeHeadIndex) * 16777619u;
+        checksum = (checksum ^ (unsigned int)state->snakeTailIndex) * 16777619u;
+        checksum = (checksum ^ (unsigned int)MapIndex(&state->map, state->snakeX, state->snakeY)) * 16777619u;
+        checksum = (checksum ^ (unsigned int)state->gameOver) * 16777619u;
+        checksum = (checksum ^ benchFruitChecksum) * 16777619u;
+    }
+    
+    return checksum;
+}
+
+// NOTE: The checksum comes from one untimed pass over exactly opsPerSample
+// operations, which doubles as the warm-up. Timed samples then repeat that
+// pass until they last at least minSeconds so short scenarios are not
+// dominated by timer and scheduler noise.
+static bench_result
+CalibrateScenario(bench_scenario *scenario, double minSeconds)
+{
+    bench_result result = {0};
+    
+    SetupScenario(scenario);
+    double once = RunScenario(scenario);
+    result.checksum = ComputeChecksum(scenario);
+    
+    long long repeats = 1;
+    
+    if(once > 0 && once < minSeconds)
+    {
+        repeats = (long long)(minSeconds / once) + 1;
+    }
+    
+    result.opsPerSample = repeats * scenario->opsPerSample;
+    
+    return result;
+}
+
+static void
+SampleScenario(bench_scenario *scenario, bench_result *result, int firstSample)
+{
+    SetupScenario(scenario);
+    
+    double elapsed = 0;
+    long long repeats = result->opsPerSample / scenario->opsPerSample;
+    
+    for(long long repeat = 0; repeat < repeats; repeat++)
+    {
+        elapsed += RunScenario(scenario);
+    }
+    
+    double nsPerOp = elapsed * 1e9 / (double)result->opsPerSample;
+    
+    if(firstSample || nsPerOp < result->nsPerOp)
+    {
+        result->nsPerOp = nsPerOp;
+    }
+    
+    if(scenario->kind == BENCH_CLEAR_SCREEN_BUFFER || scenario->kind == BENCH_FILL_RECTANGLE)
+    {
+        double bytes = (double)scenario->bufferWidth * scenario->bufferHeight * sizeof(unsigned int);
+        result->mbPerSecond = bytes / (result->nsPerOp * 1e-9) / (1024.0 * 1024.0);
+    }
+}
+
+//------------------------------------------------------------------------------
+// Baseline
+//------------------------------------------------------------------------------
+typedef struct
+{
+    char name[64];
+    double nsPerOp;
+    unsigned int checksum;
+    int hasChecksum;
+
+} baseline_entry;
+
+static baseline_entry baseline[ArrayCount(scenarios)];
+static int baselineCount;
+
+static int
+LoadBaseline(char *path)
+{
+    FILE *file = fopen(path, "r");
+    
+    if(!file)
+    {
+        fprintf(stderr, "bench: could not open baseline '%s'\n", path);
+        return 0;
+    }
+    
+    char line[256];
+    
+    while(fgets(line, sizeof(line), file) && baselineCount < (int)ArrayCount(baseline))
+    {
+        baseline_entry *entry = &baseline[baselineCount];
+        
+        int fields = sscanf(line, "%63[^,],%lf,%*f,%*d,%x", entry->name, &entry->nsPerOp, &entry->checksum);
+        
+        if(fields >= 2)
+        {
+            entry->hasChecksum = (fields == 3);
+            baselineCount++;
+        }
+    }
+    
+    fclose(file);
+    
+    if(baselineCount == 0)
+    {
+        fprintf(stderr, "bench: no results in baseline '%s', expected a CSV written by --csv\n", path);
+        return 0;
+    }
+    
+    return 1;
+}
+
+static baseline_entry *
+FindBaseline(char *name)
+{
+    baseline_entry *result = 0;
+    
+    for(int index = 0;
+        index < baselineCount;
+        index++)
+    {
+        if(strcmp(baseline[index].name, name) == 0)
+        {
+            result = &baseline[index];
+            break;
+        }
+    }
+    
+    return result;
+}
+
+//------------------------------------------------------------------------------
+// Main
+//------------------------------------------------------------------------------
+static void
+PrintUsage(void)
+{
+    fprintf(stderr,
+            "usage: bench [options]\n"
+            "  --csv <path>        write results as CSV\n"
+            "  --json <path>       write results as JSON\n"
+            "  --baseline <path>   compare against a CSV written by --csv, checksums must match\n"
+            "  --threshold <pct>   allowed slowdown against the baseline (default 20)\n"
+            "  --samples <n>       timed samples per scenario, best is kept (default 7)\n"
+            "  --min-time <ms>     minimum duration of each timed sample (default 100)\n"
+            "  --filter <text>     only run scenarios whose name contains text\n");
+}
+
+int
+main(int argc, char **argv)
+{
+    char *csvPath = 0;
+    char *jsonPath = 0;
+    char *baselinePath = 0;
+    char *filter = 0;
+    double threshold = 20.0;
+    double minMilliseconds = 100.0;
+    int samples = 7;
+    
+    for(int argIndex = 1;
+        argIndex < argc;
+        argIndex++)
+    {
+        char *arg = argv[argIndex];
+        char *value = (argIndex + 1 < argc) ? argv[argIndex + 1] : 0;
+        
+        if(strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0)
+        {
+            PrintUsage();
+            return 0;
+        }
+        
+        if(!value)
+        {
+            PrintUsage();
+            return 2;
+        }
+        
+        if(strcmp(arg, "--csv") == 0)            csvPath = value;
+        else if(strcmp(arg, "--json") == 0)      jsonPath = value;
+        else if(strcmp(arg, "--baseline") == 0)  baselinePath = value;
+        else if(strcmp(arg, "--filter") == 0)    filter = value;
+        else if(strcmp(arg, "--threshold") == 0) threshold = atof(value);
+        else if(strcmp(arg, "--samples") == 0)   samples = Max(1, atoi(value));
+        else if(strcmp(arg, "--min-time") == 0)  minMilliseconds = Max(0.0, atof(value));
+        else
+        {
+            PrintUsage();
+            return 2;
+        }
+        
+        argIndex++;
+    }
+    
+    if(baselinePath && !LoadBaseline(baselinePath))
+    {
+        return 2;
+    }
+    
+    benchBuffer = (unsigned int *)malloc(3840 * 2160 * sizeof(unsigned int));
+    
+    if(!benchBuffer)
+    {
+        fprintf(stderr, "bench: out of memory\n");
+        return 2;
+    }
+    
+    FILE *csv = csvPath ? fopen(csvPath, "w") : 0;
+    FILE *json = jsonPath ? fopen(jsonPath, "w") : 0;
+    
+    if((csvPath && !csv) || (jsonPath && !json))
+    {
+        fprintf(stderr, "bench: could not open output file\n");
+        return 2;
+    }
+    
+    if(csv)
+    {
+        fprintf(csv, "name,ns_per_op,mb_per_s,ops_per_sample,checksum\n");
+    }
+    
+    if(json)
+    {
+        fprintf(json, "{\n  \"map_capacity\": \"%dx%d\",\n  \"samples\": %d,\n  \"min_time_ms\": %.1f,\n  \"results\": [",
+                MAP_WIDTH, MAP_HEIGHT, samples, minMilliseconds);
+    }
+    
+    printf("map capacity %dx%d, best of %d samples of at least %.0f ms\n", MAP_WIDTH, MAP_HEIGHT, samples, minMilliseconds);
+    printf("%-36s %14s %12s %10s\n", "scenario", "ns/op", "MB/s", "vs base");
+    
+    // NOTE: Samples are taken round-robin over all selected scenarios rather
+    // than back to back, so the best of each is drawn from across the whole
+    // run and a burst of machine load does not skew a single scenario.
+    int selected[ArrayCount(scenarios)];
+    bench_result results[ArrayCount(scenarios)];
+    int selectedCount = 0;
+    
+    for(int scenarioIndex = 0;
+        scenarioIndex < (int)ArrayCount(scenarios);
+        scenarioIndex++)
+    {
+        bench_scenario *scenario = &scenarios[scenarioIndex];
+        
+        if(ScenarioFitsBuild(scenario) && (!filter || strstr(scenario->name, filter)))
+        {
+            results[selectedCount] = CalibrateScenario(scenario, minMilliseconds * 1e-3);
+            selected[selectedCount++] = scenarioIndex;
+        }
+    }
+    
+    for(int sample = 0;
+        sample < samples;
+        sample++)
+    {
+        for(int index = 0; index < selectedCount; index++)
+        {
+            SampleScenario(&scenarios[selected[index]], &results[index], sample == 0);
+        }
+    }
+    
+    int regressions = 0;
+    int changed = 0;
+    int missing = 0;
+    
+    for(int index = 0;
+        index < selectedCount;
+        index++)
+    {
+        bench_scenario *scenario = &scenarios[selected[index]];
+        bench_result result = results[index];
+        
+        char delta[32] = "-";
+        baseline_entry *entry = FindBaseline(scenario->name);
+        
+        if(baselinePath && (!entry || !entry->hasChecksum))
+        {
+            // NOTE: A renamed scenario or the wrong file must not pass silently.
+            snprintf(delta, sizeof(delta), "missing!");
+            missing++;
+        }
+        else if(entry && entry->checksum != result.checksum)
+        {
+            // NOTE: A different checksum means a different workload, the timing delta is meaningless.
+            snprintf(delta, sizeof(delta), "checksum!");
+            changed++;
+        }
+        else if(entry && entry->nsPerOp > 0)
+        {
+            double change = (result.nsPerOp / entry->nsPerOp - 1.0) * 100.0;
+            int regressed = change > threshold;
+            
+            snprintf(delta, sizeof(delta), "%+.1f%%%s", change, regressed ? " !" : "");
+            regressions += regressed;
+        }
+        
+        printf("%-36s %14.2f %12.1f %10s\n", scenario->name, result.nsPerOp, result.mbPerSecond, delta);
+        
+        if(csv)
+        {
+            fprintf(csv, "%s,%.4f,%.2f,%lld,%08x\n",
+                    scenario->name, result.nsPerOp, result.mbPerSecond, result.opsPerSample, result.checksum);
+        }
+        
+        if(json)
+        {
+            fprintf(json, "%s\n    { \"name\": \"%s\", \"ns_per_op\": %.4f, \"mb_per_s\": %.2f, \"ops_per_sample\": %lld, \"checksum\": \"%08x\" }",
+                    index ? "," : "", scenario->name, result.nsPerOp, result.mbPerSecond, result.opsPerSample, result.checksum);
+        }
+    }
+    
+    if(csv)
+    {
+        fclose(csv);
+    }
+    
+    if(json)
+    {
+        fprintf(json, "\n  ],\n  \"threshold_percent\": %.2f,\n  \"regressions\": %d,\n  \"checksum_changes\": %d,\n  \"missing_from_baseline\": %d\n}\n",
+                threshold, regressions, changed, missing);
+        fclose(json);
+    }
+    
+    if(baselinePath)
+    {
+        printf("%d regression(s) over %.1f%%, %d checksum change(s) and %d scenario(s) missing from %s\n",
+               regressions, threshold, changed, missing, baselinePath);
+    }
+    
+    free(benchBuffer);
+    
+    return (regressions || changed || missing) ? 1 : 0;
+}
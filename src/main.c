@@ -5,96 +5,6 @@
 #pragma comment(lib, "user32")
 #pragma comment(lib, "gdi32")
 
-#define Min(a, b) ((a) < (b) ? (a) : (b))
-#define Max(a, b) ((a) > (b) ? (a) : (b))
-#define Clamp(a, v, b) (Min(Max(a, v), b))
-#define ArrayCount(a) (sizeof(a) / sizeof(a[0]))
-
-//------------------------------------------------------------------------------
-// Drawing
-//------------------------------------------------------------------------------
-void
-ClearScreenBuffer(void *buffer, int bufferWidth, int bufferHeight, unsigned int color)
-{
-    unsigned int *pixel = (unsigned int *)buffer;
-    unsigned int *end   = pixel + bufferWidth * bufferHeight;
-    
-    while(pixel != end)
-    {
-        *pixel++ = color;
-    }
-}
-
-void
-FillRectangle(void *buffer, int bufferWidth, int bufferHeight, 
-              int x, int y, int w, int h,
-              unsigned int color)
-{
-    unsigned int minX = Clamp(0, x, bufferWidth);
-    unsigned int minY = Clamp(0, y, bufferHeight);
-    unsigned int maxX = Clamp(0, (x + w), bufferWidth);
-    unsigned int maxY = Clamp(0, (y + h), bufferHeight);
-    
-    unsigned int *row = (unsigned int *)buffer + (minX + minY * bufferWidth);
-    
-    for(unsigned int by = minY;
-        by < maxY;
-        by++)
-    {
-        unsigned int *pixel = row;
-        
-        for(unsigned int bx = minX;
-            bx < maxX;
-            bx++)
-        {
-            *pixel++ = color;
-        }
-        
-        row += bufferWidth;
-    }
-}
-
-#define TestBit(V, B) (((V) & (1 << (B))) != 0)
-
-void DrawSingleNumber(void *buffer, int bufferWidth, int bufferHeight, 
-                      unsigned int number, 
-                      int xOffset, int yOffset, 
-                      int width, int height,
-                      unsigned int color)
-{
-#define DIGIT_PIXELS_X 3
-#define DIGIT_PIXELS_Y 5
-    
-    int digitPixelWidth = width / DIGIT_PIXELS_X;
-    int digitPixelHeight = height / DIGIT_PIXELS_Y;
-    
-    static unsigned short numbers[10] = 
-    {
-        0x7B6F, 0x4924, 0x73E7, 0x79E7, 0x49ED, 0x79CF, 0x7BC9, 0x4927, 0x7BEF, 0x49EF
-    };
-    
-    for(int dy = 0;
-        dy < DIGIT_PIXELS_Y;
-        dy++)
-    {
-        for(int dx = 0;
-            dx < DIGIT_PIXELS_X;
-            dx++)
-        {
-            if(TestBit(numbers[number], (dx + dy * 3)))
-            {
-                int x = xOffset + dx * digitPixelWidth;
-                int y = yOffset - dy * digitPixelHeight - digitPixelHeight;
-                
-                FillRectangle(buffer, bufferWidth, bufferHeight,
-                              x, y,
-                              digitPixelWidth, digitPixelHeight, color);
-            }
-        }
-    }
-}
-
-
 //------------------------------------------------------------------------------
 // Win32
 //------------------------------------------------------------------------------
@@ -111,6 +21,7 @@ typedef struct
 } win32_screenbuffer;
 
 static win32_screenbuffer screenbuffer;
+static rtl_gen_random_proc RtlGenRandom;
 
 #pragma function(memset)
 void *memset(void *dest, int c, size_t count)
@@ -119,6 +30,12 @@ void *memset(void *dest, int c, size_t count)
     return dest;
 }
 
+void
+Win32GenRandom(void *randomBuffer, unsigned int randomBufferLength)
+{
+    RtlGenRandom(randomBuffer, randomBufferLength);
+}
+
 void
 ResizeScreenBuffer(win32_screenbuffer *buffer, LONG width, LONG height)
 {
@@ -191,168 +108,7 @@ ToggleFullscreen(HWND window)
     }
 }
 
-//------------------------------------------------------------------------------
-// Snake
-//------------------------------------------------------------------------------
-
-// Config
-//------------------------------------------------------------------------------
-#define MAP_WIDTH 15
-#define MAP_HEIGHT 15
-
-// State
-//------------------------------------------------------------------------------
-typedef enum
-{
-    MAP_TILE_EMPTY,
-    MAP_TILE_SNAKE,
-    MAP_TILE_FRUIT, 
-} map_tile;
-
-typedef struct
-{
-    int width;
-    int height;
-    map_tile tiles[MAP_WIDTH * MAP_HEIGHT];
-    
-} snake_map;
-
-typedef struct
-{
-    int snakeX, snakeY;
-    int snakeDirX, snakeDirY;
-    int snakeRequestedDirX, snakeRequestedDirY;
-    
-    int snakeHeadIndex, snakeTailIndex;
-    int snakeSegments[MAP_WIDTH * MAP_HEIGHT];
-    
-    unsigned int score;
-    
-    int fruitPlaced;
-    int shouldGameOver;
-    int gameOver;
-    int screenWrap;
-    int lsdMode;
-    
-    int currentFrame;
-    int framesPerTick;
-    
-    snake_map map;
-    
-} snake_state;
-
-inline int
-MapIndex(snake_map *map, int x, int y)
-{
-    return x + y * map->width;
-}
-
-inline int
-GetTileAt(snake_map *map, int x, int y)
-{
-    int result = -1;
-    
-    if(x >= 0 && x < map->width && y >= 0 && y < map->height)
-    {
-        result = map->tiles[MapIndex(map, x, y)];
-    }
-    
-    return result;
-}
-
-void
-ResetGameState(snake_state *state)
-{
-    state->map.width = MAP_WIDTH;
-    state->map.height = MAP_HEIGHT;
-    
-    state->snakeX = state->map.width / 2;
-    state->snakeY = state->map.height / 2;
-    
-    state->snakeDirX = 1;
-    state->snakeDirY = 0;
-    
-    state->snakeRequestedDirX = 0;
-    state->snakeRequestedDirY = 0;
-    
-    state->snakeHeadIndex = state->snakeTailIndex = 0;
-    
-    state->score = 0;
-    state->fruitPlaced = 0;
-    state->shouldGameOver = 0;
-    state->gameOver = 0;
-    state->currentFrame = 0;
-    state->framesPerTick = 5;
-    
-    memset(state->map.tiles, 0, state->map.width * state->map.height * sizeof(map_tile));
-    state->snakeSegments[state->snakeHeadIndex] = MapIndex(&state->map, state->snakeX, state->snakeY);
-    state->map.tiles[state->snakeSegments[state->snakeHeadIndex]] = MAP_TILE_SNAKE;
-}
-
-void
-UpdateGameplay(snake_state *state)
-{
-    if(state->snakeRequestedDirX || state->snakeRequestedDirY)
-    {
-        state->snakeDirX = state->snakeRequestedDirX;
-        state->snakeDirY = state->snakeRequestedDirY;
-        
-        state->snakeRequestedDirX = state->snakeRequestedDirY = 0;
-    }
-    
-    int snakeNewX = state->snakeX + state->snakeDirX;
-    int snakeNewY = state->snakeY + state->snakeDirY;
-    
-    if(state->screenWrap)
-    {
-        if(snakeNewX < 0)
-            snakeNewX = state->map.width + snakeNewX;
-        else if(snakeNewX >= state->map.width)
-            snakeNewX -= state->map.width;
-        
-        if(snakeNewY < 0)
-            snakeNewY = state->map.height + snakeNewY;
-        else if(snakeNewY >= state->map.height)
-            snakeNewY -= state->map.height;
-    }
-    
-    int newTile = GetTileAt(&state->map, snakeNewX, snakeNewY);
-    
-    if(newTile == -1 || newTile == MAP_TILE_SNAKE)
-    {
-        if(!state->shouldGameOver)
-        {
-            state->shouldGameOver = 1;
-            return;
-        }
-        else
-        {
-            state->gameOver = 1;
-        }
-    }
-    else
-    {
-        if(newTile == MAP_TILE_FRUIT)
-        {
-            state->score += 10;
-            state->fruitPlaced = 0;
-        }
-        else
-        {
-            state->map.tiles[state->snakeSegments[state->snakeTailIndex]] = 0;
-            state->snakeTailIndex = (state->snakeTailIndex + 1) % ArrayCount(state->snakeSegments);;
-        }
-        
-        state->snakeHeadIndex = (state->snakeHeadIndex + 1) % ArrayCount(state->snakeSegments);
-        
-        state->snakeX = snakeNewX;
-        state->snakeY = snakeNewY;
-        
-        state->snakeSegments[state->snakeHeadIndex] = MapIndex(&state->map, state->snakeX, state->snakeY);
-        
-        state->map.tiles[state->snakeSegments[state->snakeHeadIndex]] = MAP_TILE_SNAKE;
-    }
-}
+#include "snake.c"
 
 //------------------------------------------------------------------------------
 // Application
@@ -428,13 +184,13 @@ WinMainCRTStartup(void)
     // Load Entropy Function
     //------------------------------------------------------------------------------
     HMODULE advapiDLL = LoadLibrary("Advapi32.dll");
-    rtl_gen_random_proc RtlGenRandom = (rtl_gen_random_proc)GetProcAddress(advapiDLL, "SystemFunction036");
+    RtlGenRandom = (rtl_gen_random_proc)GetProcAddress(advapiDLL, "SystemFunction036");
     
     //------------------------------------------------------------------------------
     // Init Game State
     //------------------------------------------------------------------------------
     snake_state state = {0};
-    ResetGameState(&state);
+    ResetGameState(&state, MAP_WIDTH, MAP_HEIGHT);
     
     //------------------------------------------------------------------------------
     // Main Loop
@@ -492,7 +248,7 @@ WinMainCRTStartup(void)
                         {
                             if(state.gameOver)
                             {
-                                ResetGameState(&state);
+                                ResetGameState(&state, MAP_WIDTH, MAP_HEIGHT);
                             }
                         } break;
                         
@@ -542,18 +298,7 @@ WinMainCRTStartup(void)
         //------------------------------------------------------------------------------
         // Update Game
         //------------------------------------------------------------------------------
-        while(!state.fruitPlaced)
-        {
-            unsigned int fruitIndex;
-            RtlGenRandom(&fruitIndex, sizeof(unsigned int));
-            fruitIndex = fruitIndex % (state.map.width * state.map.height);
-            
-            if(state.map.tiles[fruitIndex] == 0)
-            {
-                state.map.tiles[fruitIndex] = MAP_TILE_FRUIT;
-                state.fruitPlaced = 1;
-            }
-        }
+        PlaceFruit(&state, Win32GenRandom);
         
         if((state.currentFrame++ == state.framesPerTick) && !state.gameOver)
         {
@@ -564,72 +309,7 @@ WinMainCRTStartup(void)
         //------------------------------------------------------------------------------
         // Draw Game
         //------------------------------------------------------------------------------
-        unsigned int tileSize = screenbuffer.height / state.map.height;
-        
-        if(state.map.width > state.map.height)
-        {
-            tileSize = screenbuffer.width / state.map.width;
-        }
-        
-        unsigned int gameWidth = tileSize * state.map.width;
-        unsigned int gameHeight = tileSize * state.map.height;
-        
-        unsigned int gameOffsetX = (screenbuffer.width - gameWidth) / 2;
-        unsigned int gameOffsetY = (screenbuffer.height - gameHeight) / 2;
-        
-        // Background
-        unsigned int mapColor = 0xFF222222;
-        
-        if(state.lsdMode)
-        {
-            RtlGenRandom(&mapColor, sizeof(unsigned int));
-        }
-        
-        FillRectangle(screenbuffer.data, screenbuffer.width, screenbuffer.height, gameOffsetX, gameOffsetY, gameWidth, gameHeight, mapColor);
-        
-        // Objects
-        for(unsigned int tileIndex = 0;
-            tileIndex < ArrayCount(state.map.tiles);
-            tileIndex++)
-        {
-            unsigned int tile = state.map.tiles[tileIndex];
-            
-            if(tile)
-            {
-                unsigned int color = (tile == MAP_TILE_SNAKE) ? 0xFF555555 : 0xFFFF3300;
-                
-                if(state.lsdMode && tile == MAP_TILE_SNAKE)
-                {
-                    RtlGenRandom(&color, sizeof(unsigned int));
-                }
-                
-                unsigned int x = (tileIndex % state.map.width) * tileSize + gameOffsetX;
-                unsigned int y = (tileIndex / state.map.width) * tileSize + gameOffsetY;
-                
-                FillRectangle(screenbuffer.data, screenbuffer.width, screenbuffer.height, x, y, tileSize, tileSize, color);
-            }
-        }
-        
-        // Score
-        int digitWidth = (screenbuffer.width / 400) * DIGIT_PIXELS_X;
-        int digitHeight = (screenbuffer.width / 400) * DIGIT_PIXELS_Y;
-        int digitPadding = digitWidth / 4;
-        int digitXOffset = screenbuffer.width - gameOffsetX - digitWidth;
-        int digitYOffset = screenbuffer.height - gameOffsetY;
-        int scoreMargin = digitHeight;
-        
-        unsigned int score = state.score;
-        
-        do
-        {
-            unsigned int digit = score % 10;
-            score /= 10;
-            
-            DrawSingleNumber(screenbuffer.data, screenbuffer.width, screenbuffer.height, digit, digitXOffset - scoreMargin, digitYOffset - scoreMargin, digitWidth, digitHeight, 0xFFDDDDDD);
-            
-            digitXOffset -= digitWidth + digitPadding;
-            
-        } while(score);
+        RenderGame(&state, screenbuffer.data, screenbuffer.width, screenbuffer.height, Win32GenRandom);
         
         DisplayScreenBuffer(dc, &screenbuffer);
         